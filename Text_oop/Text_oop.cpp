@@ -3,6 +3,12 @@
 #include <conio.h>
 #include <fstream>
 #include <stack>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <cctype>
 #include <windows.h>
 
 #ifdef _WIN32
@@ -16,6 +22,647 @@
 #define KEY_DOWN 80
 #define KEY_LEFT 75
 #define KEY_RIGHT 77
+#define KEY_HOME 71
+#define KEY_END 79
+#define KEY_PAGE_UP 73
+#define KEY_PAGE_DOWN 81
+#define VIEW_HEIGHT 20
+#define VIEW_WIDTH 100
+#define PARALLEL_DIFF_THRESHOLD 100000
+#define DIFF_COST_LIMIT 64
+#define DIFF_COST_BUDGET 30000000LL
+
+// One edit of a batch: remove `length` characters at (line, index) and put `text` there.
+// Positions always refer to the text as it was before the batch was applied.
+struct EditRange {
+    int line;
+    int index;
+    int length;
+    const char* text;
+};
+
+// A change between two line arrays: old lines [old_start, old_start + old_count)
+// are replaced by new lines [new_start, new_start + new_count).
+struct DiffHunk {
+    int old_start;
+    int old_count;
+    int new_start;
+    int new_count;
+};
+
+// Line based diff: common prefix/suffix trimming, lines unique to both sides as
+// patience anchors, and linear-space Myers between the anchors.
+class LineDiff {
+private:
+    struct Segment {
+        int a_begin;
+        int a_end;
+        int b_begin;
+        int b_end;
+        int next_anchor;
+    };
+
+    // A range that still has to be diffed, or (suffix > 0) a run of matching lines
+    // starting at (a_begin, b_begin) to append once everything before it is done
+    struct Task {
+        int a_begin;
+        int a_end;
+        int b_begin;
+        int b_end;
+        int suffix;
+    };
+
+    struct Occurrence {
+        unsigned long long hash;
+        int count_a;
+        int count_b;
+        int index_a;
+        int index_b;
+    };
+
+    char** a;
+    char** b;
+    int count_a;
+    int count_b;
+    std::vector<unsigned long long> hashes_a;
+    std::vector<unsigned long long> hashes_b;
+    // Search steps left for the whole diff, shared by all worker threads
+    mutable std::atomic<long long> budget;
+
+    bool same(int i, int j) const {
+        return hashes_a[i] == hashes_b[j] && strcmp(a[i], b[j]) == 0;
+    }
+
+    // Find the middle snake of the shortest edit script and return where to split the
+    // range, or false if the range should be kept as one replacement
+    bool bisect(int a_begin, int a_end, int b_begin, int b_end, int& split_x, int& split_y) const {
+        if (budget.load() <= 0) {
+            return false;
+        }
+        int length_a = a_end - a_begin;
+        int length_b = b_end - b_begin;
+        int max_d = (length_a + length_b + 1) / 2;
+        // The search never goes past DIFF_COST_LIMIT, so neither do the diagonals
+        int v_offset = (std::min)(max_d, DIFF_COST_LIMIT);
+        int v_length = 2 * v_offset + 2;
+        std::vector<int> v1(v_length, -1);
+        std::vector<int> v2(v_length, -1);
+        v1[v_offset + 1] = 0;
+        v2[v_offset + 1] = 0;
+        int delta = length_a - length_b;
+        bool front = (delta % 2 != 0);
+        int k1_start = 0, k1_end = 0, k2_start = 0, k2_end = 0;
+
+        long long cost = 0;
+        for (int d = 0; d < max_d; ++d) {
+            if (d == DIFF_COST_LIMIT || budget.fetch_sub(cost) - cost <= 0) {
+                return split_at_furthest(a_end - a_begin, b_end - b_begin, v1, v2, v_offset, split_x, split_y);
+            }
+            cost = 0;
+            for (int k1 = -d + k1_start; k1 <= d - k1_end; k1 += 2) {
+                int k1_offset = v_offset + k1;
+                int x1;
+                if (k1 == -d || (k1 != d && v1[k1_offset - 1] < v1[k1_offset + 1])) {
+                    x1 = v1[k1_offset + 1];
+                }
+                else {
+                    x1 = v1[k1_offset - 1] + 1;
+                }
+                int y1 = x1 - k1;
+                int x1_start = x1;
+                while (x1 < length_a && y1 < length_b && same(a_begin + x1, b_begin + y1)) {
+                    x1++;
+                    y1++;
+                }
+                cost += 1 + x1 - x1_start;
+                v1[k1_offset] = x1;
+                if (x1 > length_a) {
+                    k1_end += 2;
+                }
+                else if (y1 > length_b) {
+                    k1_start += 2;
+                }
+                else if (front) {
+                    int k2_offset = v_offset + delta - k1;
+                    if (k2_offset >= 0 && k2_offset < v_length && v2[k2_offset] != -1) {
+                        int x2 = length_a - v2[k2_offset];
+                        if (x1 >= x2) {
+                            split_x = x1;
+                            split_y = y1;
+                            return true;
+                        }
+                    }
+                }
+            }
+
+            for (int k2 = -d + k2_start; k2 <= d - k2_end; k2 += 2) {
+                int k2_offset = v_offset + k2;
+                int x2;
+                if (k2 == -d || (k2 != d && v2[k2_offset - 1] < v2[k2_offset + 1])) {
+                    x2 = v2[k2_offset + 1];
+                }
+                else {
+                    x2 = v2[k2_offset - 1] + 1;
+                }
+                int y2 = x2 - k2;
+                int x2_start = x2;
+                while (x2 < length_a && y2 < length_b && same(a_end - x2 - 1, b_end - y2 - 1)) {
+                    x2++;
+                    y2++;
+                }
+                cost += 1 + x2 - x2_start;
+                v2[k2_offset] = x2;
+                if (x2 > length_a) {
+                    k2_end += 2;
+                }
+                else if (y2 > length_b) {
+                    k2_start += 2;
+                }
+                else if (!front) {
+                    int k1_offset = v_offset + delta - k2;
+                    if (k1_offset >= 0 && k1_offset < v_length && v1[k1_offset] != -1) {
+                        int x1 = v1[k1_offset];
+                        int y1 = v_offset + x1 - k1_offset;
+                        if (x1 >= length_a - x2) {
+                            split_x = x1;
+                            split_y = y1;
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        // Nothing in common: the whole range is one replacement
+        return false;
+    }
+
+    // Too expensive to stay minimal (cost limit or diff budget reached): like xdiff,
+    // split on the diagonal that got furthest in either direction. If even that path
+    // has fewer matching lines than half its edits, keep the range as one replacement.
+    bool split_at_furthest(int length_a, int length_b, const std::vector<int>& v1, const std::vector<int>& v2,
+        int v_offset, int& split_x, int& split_y) const {
+        int best_progress = -1;
+        for (int i = 0; i < (int)v1.size(); ++i) {
+            int x = v1[i];
+            int y = x - (i - v_offset);
+            if (x >= 0 && x <= length_a && y >= 0 && y <= length_b && x + y > best_progress) {
+                split_x = x;
+                split_y = y;
+                best_progress = x + y;
+            }
+        }
+        for (int i = 0; i < (int)v2.size(); ++i) {
+            int x = v2[i];
+            int y = x - (i - v_offset);
+            if (x >= 0 && x <= length_a && y >= 0 && y <= length_b && x + y > best_progress) {
+                split_x = length_a - x;
+                split_y = length_b - y;
+                best_progress = x + y;
+            }
+        }
+        return best_progress >= 2 * DIFF_COST_LIMIT;
+    }
+
+    // Append the matching line pairs of the two ranges to `matches` in order.
+    // Work is kept on an explicit stack, so deep splitting cannot overflow the call stack.
+    void diff_range(int a_begin, int a_end, int b_begin, int b_end, std::vector<std::pair<int, int>>& matches) const {
+        std::vector<Task> tasks;
+        tasks.push_back({ a_begin, a_end, b_begin, b_end, 0 });
+        while (!tasks.empty()) {
+            Task task = tasks.back();
+            tasks.pop_back();
+            if (task.suffix > 0) {
+                for (int i = 0; i < task.suffix; ++i) {
+                    matches.push_back({ task.a_begin + i, task.b_begin + i });
+                }
+                continue;
+            }
+
+            while (task.a_begin < task.a_end && task.b_begin < task.b_end && same(task.a_begin, task.b_begin)) {
+                matches.push_back({ task.a_begin, task.b_begin });
+                task.a_begin++;
+                task.b_begin++;
+            }
+            int suffix = 0;
+            while (task.a_end > task.a_begin && task.b_end > task.b_begin && same(task.a_end - 1, task.b_end - 1)) {
+                task.a_end--;
+                task.b_end--;
+                suffix++;
+            }
+            if (suffix > 0) {
+                tasks.push_back({ task.a_end, task.a_end + suffix, task.b_end, task.b_end + suffix, suffix });
+            }
+            int x, y;
+            if (task.a_begin < task.a_end && task.b_begin < task.b_end && bisect(task.a_begin, task.a_end, task.b_begin, task.b_end, x, y)) {
+                // The first half is pushed last, so it is finished first
+                tasks.push_back({ task.a_begin + x, task.a_end, task.b_begin + y, task.b_end, 0 });
+                tasks.push_back({ task.a_begin, task.a_begin + x, task.b_begin, task.b_begin + y, 0 });
+            }
+        }
+    }
+
+    // Lines that occur exactly once on each side, reduced to the longest run
+    // that keeps the same order in both arrays
+    std::vector<std::pair<int, int>> find_anchors(int a_begin, int a_end, int b_begin, int b_end) const {
+        // Open addressing table keyed by line hash, at most half full
+        size_t capacity = 16;
+        while (capacity < 2 * (size_t)(a_end - a_begin)) {
+            capacity *= 2;
+        }
+        std::vector<Occurrence> table(capacity, Occurrence{ 0, 0, 0, 0, 0 });
+        std::vector<size_t> slots(a_end - a_begin);
+        for (int i = a_begin; i < a_end; ++i) {
+            size_t slot = hashes_a[i] & (capacity - 1);
+            while (table[slot].count_a != 0 && table[slot].hash != hashes_a[i]) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            table[slot].hash = hashes_a[i];
+            table[slot].count_a++;
+            table[slot].index_a = i;
+            slots[i - a_begin] = slot;
+        }
+        for (int j = b_begin; j < b_end; ++j) {
+            size_t slot = hashes_b[j] & (capacity - 1);
+            while (table[slot].count_a != 0 && table[slot].hash != hashes_b[j]) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            if (table[slot].count_a != 0) {
+                table[slot].count_b++;
+                table[slot].index_b = j;
+            }
+        }
+
+        std::vector<std::pair<int, int>> candidates;
+        for (int i = a_begin; i < a_end; ++i) {
+            const Occurrence& occurrence = table[slots[i - a_begin]];
+            if (occurrence.count_a == 1 && occurrence.count_b == 1 && same(i, occurrence.index_b)) {
+                candidates.push_back({ i, occurrence.index_b });
+            }
+        }
+
+        // Longest increasing subsequence of the b indices (patience sorting)
+        std::vector<int> tails;
+        std::vector<int> previous(candidates.size(), -1);
+        for (int c = 0; c < (int)candidates.size(); ++c) {
+            int low = 0, high = (int)tails.size();
+            while (low < high) {
+                int middle = (low + high) / 2;
+                if (candidates[tails[middle]].second < candidates[c].second) {
+                    low = middle + 1;
+                }
+                else {
+                    high = middle;
+                }
+            }
+            if (low > 0) {
+                previous[c] = tails[low - 1];
+            }
+            if (low == (int)tails.size()) {
+                tails.push_back(c);
+            }
+            else {
+                tails[low] = c;
+            }
+        }
+
+        std::vector<std::pair<int, int>> anchors(tails.size());
+        int c = tails.empty() ? -1 : tails.back();
+        for (int i = (int)anchors.size() - 1; i >= 0; --i) {
+            anchors[i] = candidates[c];
+            c = previous[c];
+        }
+        return anchors;
+    }
+
+    void diff_segments(const std::vector<Segment>& segments, std::vector<std::vector<std::pair<int, int>>>& results, size_t first, size_t last) const {
+        for (size_t s = first; s < last; ++s) {
+            diff_range(segments[s].a_begin, segments[s].a_end, segments[s].b_begin, segments[s].b_end, results[s]);
+        }
+    }
+
+public:
+    // FNV-1a style hash that consumes 8 bytes per step
+    static unsigned long long hash_line(const char* text) {
+        size_t length = strlen(text);
+        unsigned long long hash = 14695981039346656037ULL ^ length;
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            unsigned long long word;
+            memcpy(&word, &text[i], 8);
+            hash = (hash ^ word) * 1099511628211ULL;
+            hash ^= hash >> 32;
+        }
+        for (; i < length; ++i) {
+            hash = (hash ^ (unsigned char)text[i]) * 1099511628211ULL;
+        }
+        return hash ^ (hash >> 32);
+    }
+
+    // Line hashes that are already known (e.g. cached by LineIndex) can be passed
+    // in, the rest are computed here
+    LineDiff(char** old_lines, int old_count, char** new_lines, int new_count,
+        const unsigned long long* old_hashes = nullptr, const unsigned long long* new_hashes = nullptr) {
+        a = old_lines;
+        b = new_lines;
+        count_a = old_count;
+        count_b = new_count;
+        if (old_hashes != nullptr) {
+            hashes_a.assign(old_hashes, old_hashes + old_count);
+        }
+        else {
+            hashes_a.resize(old_count);
+            for (int i = 0; i < old_count; ++i) {
+                hashes_a[i] = hash_line(old_lines[i]);
+            }
+        }
+        if (new_hashes != nullptr) {
+            hashes_b.assign(new_hashes, new_hashes + new_count);
+        }
+        else {
+            hashes_b.resize(new_count);
+            for (int j = 0; j < new_count; ++j) {
+                hashes_b[j] = hash_line(new_lines[j]);
+            }
+        }
+    }
+
+    const std::vector<unsigned long long>& new_hashes() const {
+        return hashes_b;
+    }
+
+    std::vector<DiffHunk> compute() const {
+        budget = DIFF_COST_BUDGET;
+        std::vector<std::pair<int, int>> matches;
+        int a_begin = 0, a_end = count_a, b_begin = 0, b_end = count_b;
+        while (a_begin < a_end && b_begin < b_end && same(a_begin, b_begin)) {
+            matches.push_back({ a_begin, b_begin });
+            a_begin++;
+            b_begin++;
+        }
+        int suffix = 0;
+        while (a_end > a_begin && b_end > b_begin && same(a_end - 1, b_end - 1)) {
+            a_end--;
+            b_end--;
+            suffix++;
+        }
+
+        // The ranges between two anchors are independent of each other
+        std::vector<std::pair<int, int>> anchors = find_anchors(a_begin, a_end, b_begin, b_end);
+        std::vector<Segment> segments;
+        int segment_a = a_begin, segment_b = b_begin;
+        for (size_t i = 0; i <= anchors.size(); ++i) {
+            int next_a = i < anchors.size() ? anchors[i].first : a_end;
+            int next_b = i < anchors.size() ? anchors[i].second : b_end;
+            if (next_a > segment_a || next_b > segment_b) {
+                segments.push_back({ segment_a, next_a, segment_b, next_b, (int)i });
+            }
+            segment_a = next_a + 1;
+            segment_b = next_b + 1;
+        }
+
+        std::vector<std::vector<std::pair<int, int>>> results(segments.size());
+        size_t workers = std::thread::hardware_concurrency();
+        if (workers > 1 && segments.size() > 1 && (a_end - a_begin) + (b_end - b_begin) >= PARALLEL_DIFF_THRESHOLD) {
+            workers = (std::min)(workers, segments.size());
+            std::vector<std::thread> threads;
+            for (size_t w = 0; w < workers; ++w) {
+                size_t first = segments.size() * w / workers;
+                size_t last = segments.size() * (w + 1) / workers;
+                threads.push_back(std::thread(&LineDiff::diff_segments, this, std::cref(segments), std::ref(results), first, last));
+            }
+            for (size_t w = 0; w < threads.size(); ++w) {
+                threads[w].join();
+            }
+        }
+        else {
+            diff_segments(segments, results, 0, segments.size());
+        }
+
+        size_t segment = 0;
+        for (size_t i = 0; i <= anchors.size(); ++i) {
+            if (segment < segments.size() && segments[segment].next_anchor == (int)i) {
+                matches.insert(matches.end(), results[segment].begin(), results[segment].end());
+                segment++;
+            }
+            if (i < anchors.size()) {
+                matches.push_back(anchors[i]);
+            }
+        }
+        for (int i = 0; i < suffix; ++i) {
+            matches.push_back({ a_end + i, b_end + i });
+        }
+
+        std::vector<DiffHunk> hunks;
+        int next_a = 0, next_b = 0;
+        matches.push_back({ count_a, count_b });
+        for (size_t i = 0; i < matches.size(); ++i) {
+            if (matches[i].first > next_a || matches[i].second > next_b) {
+                hunks.push_back({ next_a, matches[i].first - next_a, next_b, matches[i].second - next_b });
+            }
+            next_a = matches[i].first + 1;
+            next_b = matches[i].second + 1;
+        }
+        return hunks;
+    }
+};
+
+// Per-line metadata kept in Fenwick trees (bytes, words) and a max segment tree
+// (line length), so totals and byte offset <-> line lookups cost O(log n).
+// A line takes its length plus one byte for the line break.
+class LineIndex {
+private:
+    int count;
+    int capacity;
+    std::vector<long long> line_bytes;
+    std::vector<long long> line_words;
+    std::vector<long long> byte_tree;
+    std::vector<long long> word_tree;
+    std::vector<int> longest_tree;
+    // Line hashes for the diff, computed on first use and dropped when the line changes
+    mutable std::vector<unsigned long long> line_hashes;
+    mutable std::vector<char> hash_valid;
+
+    static long long count_words(const char* text) {
+        long long words = 0;
+        bool in_word = false;
+        for (const char* c = text; *c != '\0'; ++c) {
+            bool space = isspace((unsigned char)*c) != 0;
+            if (!space && !in_word) {
+                words++;
+            }
+            in_word = !space;
+        }
+        return words;
+    }
+
+    void add(std::vector<long long>& tree, int position, long long delta) {
+        for (int i = position + 1; i <= capacity; i += i & -i) {
+            tree[i] += delta;
+        }
+    }
+
+    // Sum of the first `end` values
+    long long prefix(const std::vector<long long>& tree, int end) const {
+        long long sum = 0;
+        for (int i = end; i > 0; i -= i & -i) {
+            sum += tree[i];
+        }
+        return sum;
+    }
+
+    void set_length(int position, int length) {
+        int node = position + capacity;
+        longest_tree[node] = length;
+        for (node /= 2; node >= 1; node /= 2) {
+            longest_tree[node] = (std::max)(longest_tree[2 * node], longest_tree[2 * node + 1]);
+        }
+    }
+
+    // Rebuild all trees from line_bytes and line_words in O(capacity)
+    void build_trees() {
+        byte_tree.assign(capacity + 1, 0);
+        word_tree.assign(capacity + 1, 0);
+        longest_tree.assign(2 * capacity, 0);
+        for (int i = 1; i <= capacity; ++i) {
+            byte_tree[i] += line_bytes[i - 1];
+            word_tree[i] += line_words[i - 1];
+            int parent = i + (i & -i);
+            if (parent <= capacity) {
+                byte_tree[parent] += byte_tree[i];
+                word_tree[parent] += word_tree[i];
+            }
+            if (i - 1 < count) {
+                longest_tree[capacity + i - 1] = (int)line_bytes[i - 1] - 1;
+            }
+        }
+        for (int node = capacity - 1; node >= 1; --node) {
+            longest_tree[node] = (std::max)(longest_tree[2 * node], longest_tree[2 * node + 1]);
+        }
+    }
+
+    void reserve(int needed) {
+        if (needed <= capacity) {
+            return;
+        }
+        int new_capacity = capacity > 0 ? capacity : 16;
+        while (new_capacity < needed) {
+            new_capacity *= 2;
+        }
+        capacity = new_capacity;
+        line_bytes.resize(capacity, 0);
+        line_words.resize(capacity, 0);
+        line_hashes.resize(capacity, 0);
+        hash_valid.resize(capacity, 0);
+        build_trees();
+    }
+
+public:
+    LineIndex() {
+        count = 0;
+        capacity = 0;
+    }
+
+    // `hashes`, if given, are the LineDiff hashes of `lines`
+    void rebuild(char** lines, int line_count, const unsigned long long* hashes = nullptr) {
+        count = line_count;
+        capacity = 0;
+        line_bytes.assign(line_count, 0);
+        line_words.assign(line_count, 0);
+        if (hashes != nullptr) {
+            line_hashes.assign(hashes, hashes + line_count);
+            hash_valid.assign(line_count, 1);
+        }
+        else {
+            line_hashes.assign(line_count, 0);
+            hash_valid.assign(line_count, 0);
+        }
+        for (int i = 0; i < line_count; ++i) {
+            line_bytes[i] = (long long)strlen(lines[i]) + 1;
+            line_words[i] = count_words(lines[i]);
+        }
+        reserve(line_count > 0 ? line_count : 1);
+    }
+
+    void update(int line, const char* text) {
+        long long bytes = (long long)strlen(text) + 1;
+        long long words = count_words(text);
+        add(byte_tree, line, bytes - line_bytes[line]);
+        add(word_tree, line, words - line_words[line]);
+        line_bytes[line] = bytes;
+        line_words[line] = words;
+        hash_valid[line] = 0;
+        set_length(line, (int)bytes - 1);
+    }
+
+    void push_back(const char* text) {
+        reserve(count + 1);
+        count++;
+        update(count - 1, text);
+    }
+
+    int line_count() const {
+        return count;
+    }
+
+    // Hashes of all lines, rehashing only the lines edited since the last call
+    const unsigned long long* hashes(char** lines) const {
+        for (int i = 0; i < count; ++i) {
+            if (!hash_valid[i]) {
+                line_hashes[i] = LineDiff::hash_line(lines[i]);
+                hash_valid[i] = 1;
+            }
+        }
+        return line_hashes.data();
+    }
+
+    int line_length(int line) const {
+        return (int)line_bytes[line] - 1;
+    }
+
+    long long total_bytes() const {
+        return prefix(byte_tree, count);
+    }
+
+    long long total_words() const {
+        return prefix(word_tree, count);
+    }
+
+    // Byte offset at which the line starts
+    long long line_offset(int line) const {
+        return prefix(byte_tree, line);
+    }
+
+    // Line that contains the byte offset, or -1 if it is past the end of the text
+    int line_at_offset(long long offset) const {
+        if (offset < 0 || offset >= total_bytes()) {
+            return -1;
+        }
+        int position = 0;
+        int step = 1;
+        while (step * 2 <= capacity) {
+            step *= 2;
+        }
+        for (; step > 0; step /= 2) {
+            if (position + step <= capacity && byte_tree[position + step] <= offset) {
+                position += step;
+                offset -= byte_tree[position];
+            }
+        }
+        return position;
+    }
+
+    // First line with the greatest length, or -1 if there are no lines
+    int longest_line() const {
+        if (count == 0) {
+            return -1;
+        }
+        int node = 1;
+        while (node < capacity) {
+            node = longest_tree[2 * node] == longest_tree[node] ? 2 * node : 2 * node + 1;
+        }
+        return node - capacity;
+    }
+};
 
 class TextEditor {
 private:
@@ -24,6 +671,10 @@ private:
     char** lines;
     int cursor_line;
     int cursor_index;
+    int view_top;
+    int view_left;
+    std::vector<std::pair<int, int>> extra_cursors;
+    LineIndex line_index;
     std::stack<char**> undo_stack;
     std::stack<char**> redo_stack;
     std::stack<int> undo_line_counts;
@@ -56,6 +707,10 @@ private:
         current_line = line_count_stack.top();
         stack.pop();
         line_count_stack.pop();
+        line_index.rebuild(lines, current_line);
+        clamp_cursors();
+        view_top = 0;
+        view_left = 0;
     }
 
     void clear_stack(std::stack<char**>& stack, std::stack<int>& line_count_stack) {
@@ -71,6 +726,132 @@ private:
         }
     }
 
+    void step_cursor_up(int& line, int& index) {
+        line--;
+        if (line < 0) line = 0;
+        index = min(index, strlen(lines[line]));
+    }
+
+    void step_cursor_down(int& line, int& index) {
+        line++;
+        if (line >= current_line) line = current_line - 1;
+        index = min(index, strlen(lines[line]));
+    }
+
+    void step_cursor_left(int& line, int& index) {
+        index--;
+        if (index < 0) {
+            if (line > 0) {
+                line--;
+                index = strlen(lines[line]);
+            }
+            else {
+                index = 0;
+            }
+        }
+    }
+
+    void step_cursor_right(int& line, int& index) {
+        index++;
+        int line_length = strlen(lines[line]);
+        if (index > line_length) {
+            index = line_length;
+            if (line < current_line - 1) {
+                line++;
+                index = 0;
+            }
+        }
+    }
+
+    void free_lines(char** to_free, int count) {
+        for (int i = 0; i < count; i++) {
+            free(to_free[i]);
+        }
+        free(to_free);
+    }
+
+    // Read every line of the file into a new array, or return nullptr on failure
+    char** read_lines_from_file(const char* filename, int& count) {
+        std::ifstream file(filename);
+        if (!file) {
+            std::cout << "Error opening file for reading" << std::endl;
+            return nullptr;
+        }
+
+        int capacity = INITIAL_BUFFER_SIZE;
+        char** result = (char**)malloc(capacity * sizeof(char*));
+        if (result == nullptr) {
+            std::cout << "Memory allocation failed" << std::endl;
+            return nullptr;
+        }
+        count = 0;
+
+        std::string buffer;
+        while (std::getline(file, buffer)) {
+            if (count == capacity) {
+                capacity *= 2;
+                char** temp = (char**)realloc(result, capacity * sizeof(char*));
+                if (temp == nullptr) {
+                    std::cout << "Memory allocation failed" << std::endl;
+                    free_lines(result, count);
+                    return nullptr;
+                }
+                result = temp;
+            }
+            result[count] = _strdup(buffer.c_str());
+            if (result[count] == nullptr) {
+                std::cout << "Memory allocation failed" << std::endl;
+                free_lines(result, count);
+                return nullptr;
+            }
+            count++;
+        }
+        return result;
+    }
+
+    // Move cursors that no longer point into the text back inside it
+    void clamp_cursors() {
+        if (current_line == 0) {
+            cursor_line = 0;
+            cursor_index = 0;
+            extra_cursors.clear();
+            return;
+        }
+        cursor_line = min(cursor_line, current_line - 1);
+        cursor_index = min(cursor_index, (int)strlen(lines[cursor_line]));
+        for (size_t i = 0; i < extra_cursors.size(); ++i) {
+            extra_cursors[i].first = min(extra_cursors[i].first, current_line - 1);
+            extra_cursors[i].second = min(extra_cursors[i].second, (int)strlen(lines[extra_cursors[i].first]));
+        }
+        merge_cursors();
+    }
+
+    // Move the extra cursors of `line` after `length` symbols at `index` were replaced by
+    // `text_length` new ones, by the same rule apply_edits uses, then clamp all cursors
+    void shift_cursors(int line, int index, int length, int text_length) {
+        std::vector<std::pair<int, int>>::iterator it = std::lower_bound(extra_cursors.begin(), extra_cursors.end(), std::make_pair(line, 0));
+        for (; it != extra_cursors.end() && it->first == line; ++it) {
+            if (index + length <= it->second) {
+                it->second += text_length - length;
+            }
+            else if (index <= it->second) {
+                it->second = index + text_length;
+            }
+        }
+        clamp_cursors();
+    }
+
+    // Keep extra cursors sorted and drop the ones that ended up on the same position
+    void merge_cursors() {
+        std::sort(extra_cursors.begin(), extra_cursors.end());
+        extra_cursors.erase(std::unique(extra_cursors.begin(), extra_cursors.end()), extra_cursors.end());
+        std::pair<int, int> primary(cursor_line, cursor_index);
+        std::vector<std::pair<int, int>>::iterator it = std::lower_bound(extra_cursors.begin(), extra_cursors.end(), primary);
+        if (it != extra_cursors.end() && *it == primary) {
+            extra_cursors.erase(it);
+        }
+    }
+
 public:
     TextEditor() {
         current_line = 0;
@@ -78,6 +859,8 @@ public:
         lines = nullptr;
         cursor_line = 0;
         cursor_index = 0;
+        view_top = 0;
+        view_left = 0;
     }
 
     ~TextEditor() {
@@ -97,65 +880,231 @@ public:
     void display_text_with_cursor() {
 
         system(CLEAR_COMMAND);
-        for (int i = 0; i < current_line; ++i) {
+        // Keep the cursor inside the window and draw only the window
+        if (cursor_line < view_top) {
+            view_top = cursor_line;
+        }
+        else if (cursor_line >= view_top + VIEW_HEIGHT) {
+            view_top = cursor_line - VIEW_HEIGHT + 1;
+        }
+        if (cursor_index < view_left) {
+            view_left = cursor_index;
+        }
+        else if (cursor_index >= view_left + VIEW_WIDTH) {
+            view_left = cursor_index - VIEW_WIDTH + 1;
+        }
+        int last_line = (std::min)(current_line, view_top + VIEW_HEIGHT);
+
+        std::string output;
+        output.reserve((size_t)(last_line - view_top) * (VIEW_WIDTH + 2) + 80);
+        size_t next_cursor = std::lower_bound(extra_cursors.begin(), extra_cursors.end(), std::make_pair(view_top, 0)) - extra_cursors.begin();
+        std::vector<int> marks;
+        for (int i = view_top; i < last_line; ++i) {
+            marks.clear();
             if (i == cursor_line) {
-                for (int j = 0; j < strlen(lines[i]); ++j) {
-                    if (j == cursor_index) {
-                        std::cout << '|'; // Символ курсору
+                marks.push_back(cursor_index);
+            }
+            while (next_cursor < extra_cursors.size() && extra_cursors[next_cursor].first == i) {
+                marks.push_back(extra_cursors[next_cursor].second);
+                next_cursor++;
+            }
+            int line_length = line_index.line_length(i);
+            int from = (std::min)(view_left, line_length);
+            int to = (std::min)(view_left + VIEW_WIDTH, line_length);
+            std::sort(marks.begin(), marks.end());
+            int position = from;
+            for (size_t m = 0; m < marks.size(); ++m) {
+                // Cursors left or right of the window are not drawn; one at the end of the line is
+                if (marks[m] < from || marks[m] > to || (marks[m] == view_left + VIEW_WIDTH && to < line_length)) {
+                    continue;
+                }
+                output.append(lines[i] + position, marks[m] - position);
+                output += '|'; // Символ курсору
+                position = marks[m];
+            }
+            output.append(lines[i] + position, to - position);
+            output += '\n';
+        }
+        output += "Line " + std::to_string(cursor_line) + ", Index " + std::to_string(cursor_index)
+            + " | Lines: " + std::to_string(line_index.line_count())
+            + " | Bytes: " + std::to_string(line_index.total_bytes())
+            + " | Words: " + std::to_string(line_index.total_words()) + "\n";
+        std::cout.write(output.data(), output.size());
+        std::cout.flush();
+    }
+
+    // Print only lines [first_line, first_line + line_count), each cut to the columns
+    // [first_column, first_column + width), as one write
+    void display_text_range(int first_line, int line_count, int first_column, int width) const {
+        if (current_line == 0) {
+            std::cout << "No lines" << std::endl;
+            return;
+        }
+        int last_line = (std::min)(current_line, first_line + line_count);
+        std::string output;
+        output.reserve((size_t)(last_line - first_line) * (width + 1) + 80);
+        output += "Lines " + std::to_string(first_line) + "-" + std::to_string(last_line - 1)
+            + " of " + std::to_string(current_line) + ", from index " + std::to_string(first_column) + ":\n";
+        for (int i = first_line; i < last_line; ++i) {
+            int line_length = line_index.line_length(i);
+            if (first_column < line_length) {
+                output.append(lines[i] + first_column, (std::min)(width, line_length - first_column));
+            }
+            output += '\n';
+        }
+        std::cout.write(output.data(), output.size());
+        std::cout.flush();
+    }
+
+    // Зсунути вікно перегляду, не виходячи за межі тексту
+    void scroll_view(int lines_delta, int columns_delta) {
+        int longest = line_index.longest_line();
+        int max_top = (std::max)(0, current_line - VIEW_HEIGHT);
+        int max_left = longest < 0 ? 0 : (std::max)(0, line_index.line_length(longest) - VIEW_WIDTH);
+        view_top = (std::max)(0, (std::min)(max_top, view_top + lines_delta));
+        view_left = (std::max)(0, (std::min)(max_left, view_left + columns_delta));
+    }
+
+    void page_up() {
+        scroll_view(-VIEW_HEIGHT, 0);
+    }
+
+    void page_down() {
+        scroll_view(VIEW_HEIGHT, 0);
+    }
+
+    bool go_to_line(int line) {
+        if (line >= current_line || line < 0) {
+            std::cout << "Invalid line number." << std::endl;
+            return false;
+        }
+        cursor_line = line;
+        cursor_index = 0;
+        merge_cursors();
+        view_top = line;
+        scroll_view(0, 0);
+        return true;
+    }
+
+    void display_view() {
+        scroll_view(0, 0);
+        display_text_range(view_top, VIEW_HEIGHT, view_left, VIEW_WIDTH);
+    }
+
+    void view_text_with_keys() {
+        bool redraw = true;
+        while (true) {
+            if (redraw) {
+                system(CLEAR_COMMAND);
+                display_view();
+                std::cout << "PgUp/PgDn, Home/End, arrows - scroll, G - go to line, Enter - exit" << std::endl;
+                redraw = false;
+            }
+
+            if (_kbhit()) {
+                int ch = _getch();
+                if (ch == 224) { // Special keys (arrows, paging)
+                    switch (_getch()) {
+                    case KEY_UP:
+                        scroll_view(-1, 0);
+                        break;
+                    case KEY_DOWN:
+                        scroll_view(1, 0);
+                        break;
+                    case KEY_LEFT:
+                        scroll_view(0, -VIEW_WIDTH / 2);
+                        break;
+                    case KEY_RIGHT:
+                        scroll_view(0, VIEW_WIDTH / 2);
+                        break;
+                    case KEY_PAGE_UP:
+                        page_up();
+                        break;
+                    case KEY_PAGE_DOWN:
+                        page_down();
+                        break;
+                    case KEY_HOME:
+                        scroll_view(-current_line, 0);
+                        break;
+                    case KEY_END:
+                        scroll_view(current_line, 0);
+                        break;
                     }
-                    std::cout << lines[i][j];
+                    redraw = true;
                 }
-                // Якщо курсор в кінці рядка
-                if (cursor_index == strlen(lines[i])) {
-                    std::cout << '|';
+                else if (ch == 'g' || ch == 'G') {
+                    std::cout << "Enter line number: ";
+                    int line;
+                    // Keep the view (and any error message) as is unless the line changed
+                    if (scanf_s("%d", &line) == 1 && go_to_line(line)) {
+                        redraw = true;
+                    }
+                    while (getchar() != '\n');
+                }
+
+                // Exit loop when Enter is pressed
+                if (ch == 13) { // Enter key
+                    break;
                 }
-                std::cout << std::endl;
-            }
-            else {
-                std::cout << lines[i] << std::endl;
             }
+
+            Sleep(100); // Small delay to prevent high CPU usage
         }
     }
 
-    // Перемістити курсор вгору
+    // Додати ще один курсор
+    void add_cursor(int line, int index) {
+        if (line >= current_line || line < 0) {
+            std::cout << "Invalid line number." << std::endl;
+            return;
+        }
+        if (index > (int)strlen(lines[line]) || index < 0) {
+            std::cout << "Invalid index." << std::endl;
+            return;
+        }
+        extra_cursors.push_back({ line, index });
+        merge_cursors();
+    }
+
+    // Залишити лише основний курсор
+    void clear_cursors() {
+        extra_cursors.clear();
+    }
+
+    // Перемістити курсори вгору
     void move_cursor_up() {
-        cursor_line--;
-        if (cursor_line < 0) cursor_line = 0;
-        cursor_index = min(cursor_index, strlen(lines[cursor_line]));
+        step_cursor_up(cursor_line, cursor_index);
+        for (size_t i = 0; i < extra_cursors.size(); ++i) {
+            step_cursor_up(extra_cursors[i].first, extra_cursors[i].second);
+        }
+        merge_cursors();
     }
 
-    // Перемістити курсор вниз
+    // Перемістити курсори вниз
     void move_cursor_down() {
-        cursor_line++;
-        if (cursor_line >= current_line) cursor_line = current_line - 1;
-        cursor_index = min(cursor_index, strlen(lines[cursor_line]));
+        step_cursor_down(cursor_line, cursor_index);
+        for (size_t i = 0; i < extra_cursors.size(); ++i) {
+            step_cursor_down(extra_cursors[i].first, extra_cursors[i].second);
+        }
+        merge_cursors();
     }
 
-    // Перемістити курсор вліво
+    // Перемістити курсори вліво
     void move_cursor_left() {
-        cursor_index--;
-        if (cursor_index < 0) {
-            if (cursor_line > 0) {
-                cursor_line--;
-                cursor_index = strlen(lines[cursor_line]);
-            }
-            else {
-                cursor_index = 0;
-            }
+        step_cursor_left(cursor_line, cursor_index);
+        for (size_t i = 0; i < extra_cursors.size(); ++i) {
+            step_cursor_left(extra_cursors[i].first, extra_cursors[i].second);
         }
+        merge_cursors();
     }
 
-    // Перемістити курсор вправо
+    // Перемістити курсори вправо
     void move_cursor_right() {
-        cursor_index++;
-        int line_length = strlen(lines[cursor_line]);
-        if (cursor_index > line_length) {
-            cursor_index = line_length;
-            if (cursor_line < current_line - 1) {
-                cursor_line++;
-                cursor_index = 0;
-            }
+        step_cursor_right(cursor_line, cursor_index);
+        for (size_t i = 0; i < extra_cursors.size(); ++i) {
+            step_cursor_right(extra_cursors[i].first, extra_cursors[i].second);
         }
+        merge_cursors();
     }
 
     void move_cursor_with_keys() {
@@ -215,6 +1164,7 @@ public:
             strcat_s(lines[current_line - 1], original_length + to_append_length + 2, " ");
         }
         strcat_s(lines[current_line - 1], original_length + to_append_length + 2, to_append);
+        line_index.update(current_line - 1, lines[current_line - 1]);
     }
 
     void start_new_line() {
@@ -229,6 +1179,7 @@ public:
         delete[] lines;
         lines = temp;
         current_line++;
+        line_index.push_back(lines[current_line - 1]);
     }
 
     void save_to_file(const char* filename) {
@@ -249,9 +1200,9 @@ public:
     }
 
     void load_from_file(const char* filename) {
-        std::ifstream file(filename);
-        if (!file) {
-            std::cout << "Error opening file for reading" << std::endl;
+        int loaded_count = 0;
+        char** loaded = read_lines_from_file(filename, loaded_count);
+        if (loaded == nullptr) {
             return;
         }
         if (lines != nullptr) {
@@ -259,85 +1210,104 @@ public:
                 free(lines[i]);
             }
             free(lines);
-            lines = nullptr;
         }
-        int current_line1 = 0;
+        lines = loaded;
+        current_line = loaded_count;
+        line_index.rebuild(lines, current_line);
+        view_top = 0;
+        view_left = 0;
+        clamp_cursors();
 
-        size_t buffer_size = INITIAL_BUFFER_SIZE;
-        char* buffer = (char*)malloc(buffer_size);
-        if (buffer == nullptr) {
-            std::cout << "Memory allocation failed" << std::endl;
-            file.close();
+        std::cout << "Text loaded successfully from " << filename << ":" << std::endl;
+        display_text_range(0, VIEW_HEIGHT, 0, VIEW_WIDTH);
+    }
+
+    std::vector<DiffHunk> diff_with(const TextEditor& other) const {
+        return LineDiff(lines, current_line, other.lines, other.current_line,
+            line_index.hashes(lines), other.line_index.hashes(other.lines)).compute();
+    }
+
+    void print_diff_with_file(const char* filename) {
+        int file_count = 0;
+        char** file_lines = read_lines_from_file(filename, file_count);
+        if (file_lines == nullptr) {
             return;
         }
+        std::vector<DiffHunk> hunks = LineDiff(lines, current_line, file_lines, file_count, line_index.hashes(lines)).compute();
+        if (hunks.empty()) {
+            std::cout << "No differences with " << filename << std::endl;
+        }
+        for (size_t h = 0; h < hunks.size(); ++h) {
+            const DiffHunk& hunk = hunks[h];
+            std::cout << "@@ -" << hunk.old_start + 1 << "," << hunk.old_count
+                << " +" << hunk.new_start + 1 << "," << hunk.new_count << " @@" << std::endl;
+            for (int i = 0; i < hunk.old_count; ++i) {
+                std::cout << "-" << lines[hunk.old_start + i] << std::endl;
+            }
+            for (int i = 0; i < hunk.new_count; ++i) {
+                std::cout << "+" << file_lines[hunk.new_start + i] << std::endl;
+            }
+        }
+        free_lines(file_lines, file_count);
+    }
 
-        lines = (char**)malloc(sizeof(char*));
-        if (lines == nullptr) {
+    // Bring the text in line with the file, replacing only the lines that differ.
+    // Unchanged lines keep their buffers, and the whole reload is one undo step.
+    void reload_from_file(const char* filename) {
+        int file_count = 0;
+        char** file_lines = read_lines_from_file(filename, file_count);
+        if (file_lines == nullptr) {
+            return;
+        }
+        LineDiff diff(lines, current_line, file_lines, file_count, line_index.hashes(lines));
+        std::vector<DiffHunk> hunks = diff.compute();
+        if (hunks.empty()) {
+            free_lines(file_lines, file_count);
+            std::cout << "Text is already up to date with " << filename << std::endl;
+            return;
+        }
+
+        char** updated = (char**)malloc((file_count + 1) * sizeof(char*));
+        if (updated == nullptr) {
             std::cout << "Memory allocation failed" << std::endl;
-            file.close();
-            free(buffer);
+            free_lines(file_lines, file_count);
             return;
         }
+        save_snapshot(undo_stack, undo_line_counts);
+        clear_stack(redo_stack, redo_line_counts);
 
-        while (file.getline(buffer, buffer_size)) {
-            size_t len = strlen(buffer);
-            while (len > 0 && buffer[len - 1] != '\n') {
-                buffer_size *= 2;
-                buffer = (char*)realloc(buffer, buffer_size);
-                if (buffer == nullptr) {
-                    std::cout << "Memory allocation failed" << std::endl;
-                    file.close();
-                    for (int i = 0; i < current_line1; i++) {
-                        free(lines[i]);
-                    }
-                    free(lines);
-                    return;
-                }
-                if (!file.getline(buffer + len, buffer_size - len)) {
-                    break;
-                }
-                len = strlen(buffer);
+        int old_line = 0;
+        int new_line = 0;
+        for (size_t h = 0; h <= hunks.size(); ++h) {
+            // Lines in front of the hunk are equal on both sides: keep our buffers
+            int unchanged = h < hunks.size() ? hunks[h].new_start - new_line : file_count - new_line;
+            for (int i = 0; i < unchanged; ++i) {
+                updated[new_line] = lines[old_line];
+                free(file_lines[new_line]);
+                old_line++;
+                new_line++;
             }
-
-            buffer[strcspn(buffer, "\n")] = '\0';
-
-            lines[current_line1] = _strdup(buffer);
-            if (lines[current_line1] == nullptr) {
-                std::cout << "Memory allocation failed" << std::endl;
-                file.close();
-                free(buffer);
-                for (int i = 0; i < current_line1; i++) {
-                    free(lines[i]);
-                }
-                free(lines);
-                return;
+            if (h == hunks.size()) {
+                break;
             }
-            current_line1++;
-
-            // Resize the lines array if needed
-            char** temp = (char**)realloc(lines, (current_line1 + 1) * sizeof(char*));
-            if (temp == nullptr) {
-                std::cout << "Memory allocation failed" << std::endl;
-                file.close();
-                free(buffer);
-                for (int i = 0; i < current_line1; i++) {
-                    free(lines[i]);
-                }
-                free(lines);
-                return;
+            for (int i = 0; i < hunks[h].old_count; ++i) {
+                free(lines[old_line]);
+                old_line++;
+            }
+            for (int i = 0; i < hunks[h].new_count; ++i) {
+                updated[new_line] = file_lines[new_line];
+                new_line++;
             }
-            lines = temp;
-        }
-
-        free(buffer);
-        file.close();
-
-        current_line = current_line1;
-
-        std::cout << "Text loaded successfully from " << filename << ":" << std::endl;
-        for (int i = 0; i < current_line; i++) {
-            std::cout << lines[i] << std::endl;
         }
+        free(file_lines);
+        free(lines);
+        lines = updated;
+        current_line = file_count;
+        // The text now equals the file, so the file's line hashes are ours
+        line_index.rebuild(lines, current_line, diff.new_hashes().data());
+        clamp_cursors();
+
+        std::cout << "Reloaded " << hunks.size() << " changed region(s) from " << filename << std::endl;
     }
 
     void insert_text(int line, int index, const char* text) {
@@ -363,6 +1333,8 @@ public:
 
         memmove(&lines[line][index + text_length], &lines[line][index], line_length - index + 1);
         memcpy(&lines[line][index], text, text_length);
+        line_index.update(line, lines[line]);
+        shift_cursors(line, index, 0, (int)text_length);
     }
 
     void insert_text_with_replacement(int line, int index, const char* text) {
@@ -391,6 +1363,8 @@ public:
         if (index + text_length > line_length) {
             lines[line][index + text_length] = '\0';
         }
+        line_index.update(line, lines[line]);
+        shift_cursors(line, index, (int)(std::min)(text_length, line_length - index), (int)text_length);
     }
 
     void search_text(const char* text_to_search) {
@@ -429,6 +1403,174 @@ public:
             std::cout << "Memory allocation failed" << std::endl;
             return;
         }
+        line_index.update(line, lines[line]);
+        shift_cursors(line, index, length, 0);
+    }
+
+    // Apply a batch of edits in one pass and record them as a single undo step.
+    // The batch is rejected as a whole if any edit is out of range or two edits overlap.
+    bool apply_edits(std::vector<EditRange> edits) {
+        if (edits.empty()) {
+            return true;
+        }
+        std::sort(edits.begin(), edits.end(), [](const EditRange& a, const EditRange& b) {
+            return a.line != b.line ? a.line < b.line : a.index < b.index;
+        });
+
+        std::vector<size_t> text_lengths(edits.size());
+        size_t line_length = 0;
+        for (size_t i = 0; i < edits.size(); ++i) {
+            const EditRange& edit = edits[i];
+            if (edit.line >= current_line || edit.line < 0) {
+                std::cout << "Invalid line number." << std::endl;
+                return false;
+            }
+            bool same_line = i > 0 && edits[i - 1].line == edit.line;
+            if (!same_line) {
+                line_length = strlen(lines[edit.line]);
+            }
+            if (edit.index < 0 || edit.length < 0 || (size_t)(edit.index + edit.length) > line_length) {
+                std::cout << "Invalid index or length." << std::endl;
+                return false;
+            }
+            if (same_line && (edits[i - 1].index == edit.index || edits[i - 1].index + edits[i - 1].length > edit.index)) {
+                std::cout << "Overlapping edits at line " << edit.line << ", index " << edit.index << "." << std::endl;
+                return false;
+            }
+            text_lengths[i] = edit.text != nullptr ? strlen(edit.text) : 0;
+        }
+
+        save_snapshot(undo_stack, undo_line_counts);
+        clear_stack(redo_stack, redo_line_counts);
+
+        // All cursors in document order, so they can be shifted while walking the edits
+        std::pair<int, int> primary(cursor_line, cursor_index);
+        std::vector<std::pair<int, int>*> cursors;
+        cursors.push_back(&primary);
+        for (size_t i = 0; i < extra_cursors.size(); ++i) {
+            cursors.push_back(&extra_cursors[i]);
+        }
+        std::sort(cursors.begin(), cursors.end(), [](const std::pair<int, int>* a, const std::pair<int, int>* b) {
+            return *a < *b;
+        });
+        size_t next_cursor = 0;
+
+        size_t group_begin = 0;
+        while (group_begin < edits.size()) {
+            int line = edits[group_begin].line;
+            size_t old_length = strlen(lines[line]);
+            long long new_length = old_length;
+            size_t group_end = group_begin;
+            while (group_end < edits.size() && edits[group_end].line == line) {
+                new_length += (long long)text_lengths[group_end] - edits[group_end].length;
+                group_end++;
+            }
+
+            char* updated = (char*)malloc(new_length + 1);
+            if (updated == nullptr) {
+                std::cout << "Memory allocation failed" << std::endl;
+                return false;
+            }
+            size_t from = 0;
+            size_t to = 0;
+            for (size_t i = group_begin; i < group_end; ++i) {
+                memcpy(&updated[to], &lines[line][from], edits[i].index - from);
+                to += edits[i].index - from;
+                memcpy(&updated[to], edits[i].text, text_lengths[i]);
+                to += text_lengths[i];
+                from = edits[i].index + edits[i].length;
+            }
+            memcpy(&updated[to], &lines[line][from], old_length - from + 1);
+            free(lines[line]);
+            lines[line] = updated;
+            line_index.update(line, updated);
+
+            // Shift cursors of this line by the size change of the edits in front of them
+            while (next_cursor < cursors.size() && cursors[next_cursor]->first < line) {
+                next_cursor++;
+            }
+            long long shift = 0;
+            size_t edit = group_begin;
+            while (next_cursor < cursors.size() && cursors[next_cursor]->first == line) {
+                int& index = cursors[next_cursor]->second;
+                while (edit < group_end && edits[edit].index + edits[edit].length <= index) {
+                    shift += (long long)text_lengths[edit] - edits[edit].length;
+                    edit++;
+                }
+                if (edit < group_end && edits[edit].index <= index) {
+                    // Cursor at the start of or inside a removed range lands right after
+                    // the new text, just like a cursor at an insertion point
+                    index = (int)(edits[edit].index + shift + text_lengths[edit]);
+                }
+                else {
+                    index = (int)(index + shift);
+                }
+                next_cursor++;
+            }
+
+            group_begin = group_end;
+        }
+
+        cursor_line = primary.first;
+        cursor_index = primary.second;
+        merge_cursors();
+        return true;
+    }
+
+    void insert_text_at_cursors(const char* text) {
+        std::vector<EditRange> edits;
+        edits.push_back({ cursor_line, cursor_index, 0, text });
+        for (size_t i = 0; i < extra_cursors.size(); ++i) {
+            edits.push_back({ extra_cursors[i].first, extra_cursors[i].second, 0, text });
+        }
+        apply_edits(edits);
+    }
+
+    void delete_text_at_cursors(int length) {
+        std::vector<EditRange> edits;
+        edits.push_back({ cursor_line, cursor_index, length, "" });
+        for (size_t i = 0; i < extra_cursors.size(); ++i) {
+            edits.push_back({ extra_cursors[i].first, extra_cursors[i].second, length, "" });
+        }
+        apply_edits(edits);
+    }
+
+    void insert_text_with_replacement_at_cursors(const char* text) {
+        int text_length = strlen(text);
+        std::vector<EditRange> edits;
+        edits.push_back({ cursor_line, cursor_index, 0, text });
+        for (size_t i = 0; i < extra_cursors.size(); ++i) {
+            edits.push_back({ extra_cursors[i].first, extra_cursors[i].second, 0, text });
+        }
+        // Overwrite as much of the line as the text covers, like insert_text_with_replacement
+        for (size_t i = 0; i < edits.size(); ++i) {
+            int line_length = strlen(lines[edits[i].line]);
+            edits[i].length = min(text_length, line_length - edits[i].index);
+        }
+        apply_edits(edits);
+    }
+
+    void show_statistics() const {
+        std::cout << "Lines: " << line_index.line_count() << std::endl;
+        std::cout << "Bytes: " << line_index.total_bytes() << std::endl;
+        std::cout << "Words: " << line_index.total_words() << std::endl;
+        int longest = line_index.longest_line();
+        if (longest >= 0) {
+            std::cout << "Longest line: " << longest << " (" << line_index.line_length(longest) << " symbols)" << std::endl;
+        }
+    }
+
+    // Поставити курсор на символ з заданим зміщенням від початку тексту
+    bool go_to_byte_offset(long long offset) {
+        int line = line_index.line_at_offset(offset);
+        if (line < 0) {
+            std::cout << "Invalid byte offset." << std::endl;
+            return false;
+        }
+        cursor_line = line;
+        cursor_index = (int)(offset - line_index.line_offset(line));
+        merge_cursors();
+        return true;
     }
 
     void copy_text(int line, int index, int length) {
@@ -504,6 +1646,17 @@ public:
         std::cout << "15. Insert with replacement" << std::endl;
         std::cout << "16. Show menu" << std::endl;
         std::cout << "17. Exit" << std::endl;
+        std::cout << "18. Add cursor" << std::endl;
+        std::cout << "19. Insert text at all cursors" << std::endl;
+        std::cout << "20. Delete text at all cursors" << std::endl;
+        std::cout << "21. Insert with replacement at all cursors" << std::endl;
+        std::cout << "22. Remove extra cursors" << std::endl;
+        std::cout << "23. Compare text with file" << std::endl;
+        std::cout << "24. Reload changed lines from file" << std::endl;
+        std::cout << "25. Show text statistics" << std::endl;
+        std::cout << "26. Go to byte offset" << std::endl;
+        std::cout << "27. View text page by page" << std::endl;
+        std::cout << "28. Go to line" << std::endl;
     }
     int set_cursor() {
         move_cursor_with_keys();
@@ -575,8 +1728,8 @@ inline void TextEditor::run() {
         std::cout << "Enter the command: ";
 
         std::cin >> command;
-        if (command < 1 || command > 17) {
-            std::cout << "Invalid command. Please enter a number between 1 and 17." << std::endl;
+        if (command < 1 || command > 28) {
+            std::cout << "Invalid command. Please enter a number between 1 and 28." << std::endl;
             continue;
         }
         show_menu();
@@ -739,6 +1892,113 @@ inline void TextEditor::run() {
         case 17:
             std::cout << "Exiting..." << std::endl;
             exit(0);
+        case 18: {
+            std::cout << "Enter line and index for the new cursor:" << std::endl;
+            int line, index;
+            if (scanf_s("%d %d", &line, &index) != 2) {
+                std::cout << "Invalid input. Please enter two numbers." << std::endl;
+                while (getchar() != '\n');
+                break;
+            }
+            getchar();
+            add_cursor(line, index);
+            break;
+        }
+        case 19: {
+            move_cursor_with_keys();
+            std::cout << "Enter text to insert at all cursors:" << std::endl;
+            std::cin.ignore();
+            char* text = read_line();
+            insert_text_at_cursors(text);
+            free(text);
+            break;
+        }
+        case 20: {
+            move_cursor_with_keys();
+            std::cout << "Choose length to delete at all cursors:" << std::endl;
+            std::cin.ignore();
+            int  length;
+            if (scanf_s("%d", &length) != 1) {
+                std::cout << "Invalid input. Please enter one numbers." << std::endl;
+                while (getchar() != '\n');
+                break;
+            }
+            getchar();
+            delete_text_at_cursors(length);
+            break;
+        }
+        case 21: {
+            move_cursor_with_keys();
+            std::cout << "Enter text to insert with replacement at all cursors:" << std::endl;
+            std::cin.ignore();
+            char* text = read_line();
+            insert_text_with_replacement_at_cursors(text);
+            free(text);
+            break;
+        }
+        case 22: {
+            clear_cursors();
+            std::cout << "Extra cursors removed" << std::endl;
+            break;
+        }
+        case 23: {
+            clear_console();
+            std::cout << "Enter the file name to compare with: ";
+            std::cin.ignore();
+            char* filename = read_line();
+
+            print_diff_with_file(filename);
+            free(filename);
+            break;
+        }
+        case 24: {
+            clear_console();
+            std::cout << "Enter the file name for reloading: ";
+            std::cin.ignore();
+            char* filename = read_line();
+
+            reload_from_file(filename);
+            free(filename);
+            break;
+        }
+        case 25: {
+            clear_console();
+            show_statistics();
+            break;
+        }
+        case 26: {
+            std::cout << "Enter byte offset:" << std::endl;
+            long long offset;
+            if (scanf_s("%lld", &offset) != 1) {
+                std::cout << "Invalid input. Please enter one numbers." << std::endl;
+                while (getchar() != '\n');
+                break;
+            }
+            getchar();
+            if (go_to_byte_offset(offset)) {
+                display_text_with_cursor();
+            }
+            break;
+        }
+        case 27: {
+            view_text_with_keys();
+            break;
+        }
+        case 28: {
+            std::cout << "Enter line number:" << std::endl;
+            int line;
+            if (scanf_s("%d", &line) != 1) {
+                std::cout << "Invalid input. Please enter one numbers." << std::endl;
+                while (getchar() != '\n');
+                break;
+            }
+            getchar();
+            if (go_to_line(line)) {
+                clear_console();
+                display_view();
+            }
+            break;
+        }
         default:
             std::cout << "The command is not implemented." << std::endl;
         }